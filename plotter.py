@@ -15,6 +15,7 @@ type PlotData = np.ndarray[tuple[int, ...], np.dtype]
 type FitFunc = Callable[[PlotData], PlotData] | np.poly1d
 
 PLOTS_DIR = "plots"
+MEMORY_COLUMNS = ["alloc_count", "alloc_bytes", "peak_bytes"]
 os.makedirs(PLOTS_DIR, exist_ok=True)
 
 
@@ -101,11 +102,15 @@ def process_csv_file(file_path: Path) -> FitData:
     # noinspection PyUnresolvedReferences
     colors: list[tuple[float, float, float]] = plt.cm.tab10.colors
 
-    df = pd.read_csv(file_path)
-    plt.figure(figsize=(21, 7))
+    # Resumed runs may append test cases out of order
+    df = pd.read_csv(file_path).sort_values("n")
+    # Memory columns are only present when built with UHR_TRACK_MEMORY
+    has_memory = all(column in df.columns for column in MEMORY_COLUMNS)
+    subplots = 3 if has_memory else 2
+    plt.figure(figsize=(10.5 * subplots, 7))
 
     # subplot 1
-    plt.subplot(1, 2, 1)
+    plt.subplot(1, subplots, 1)
 
     plt.errorbar(df["n"], df["t_mean"], yerr=df["t_stdev"], fmt="o-", capsize=5,
                  ecolor=colors[1], color=colors[2], markersize=5)
@@ -119,7 +124,7 @@ def process_csv_file(file_path: Path) -> FitData:
                  fontsize=16, bbox=dict(boxstyle="round,pad=0.3", fc="white", ec="gray", alpha=0.8))
 
     # subplot 2
-    plt.subplot(1, 2, 2)
+    plt.subplot(1, subplots, 2)
     plt.plot(df["n"], df["t_Q0"], "o-", label="Minimum (Q0)")
     plt.plot(df["n"], df["t_Q1"], "s-", label="Q1")
     plt.plot(df["n"], df["t_Q2"], "^-", label="Median (Q2)")
@@ -131,6 +136,24 @@ def process_csv_file(file_path: Path) -> FitData:
     plt.legend(fontsize=16, loc="best")
     plt.grid(True, linestyle="--", alpha=0.7)
 
+    if has_memory:
+        # subplot 3
+        ax_bytes = plt.subplot(1, subplots, 3)
+        ax_bytes.plot(df["n"], df["alloc_bytes"], "o-", color=colors[0], label="Bytes allocated")
+        ax_bytes.plot(df["n"], df["peak_bytes"], "s-", color=colors[1], label="Peak live bytes")
+        ax_bytes.set_xlabel("Number of elements (n)", fontsize=16)
+        ax_bytes.set_ylabel("Memory (bytes)", fontsize=16)
+        ax_bytes.grid(True, linestyle="--", alpha=0.7)
+
+        ax_count = ax_bytes.twinx()
+        ax_count.plot(df["n"], df["alloc_count"], "^--", color=colors[2], label="Allocations")
+        ax_count.set_ylabel("Number of allocations", fontsize=16)
+
+        handles_bytes, labels_bytes = ax_bytes.get_legend_handles_labels()
+        handles_count, labels_count = ax_count.get_legend_handles_labels()
+        ax_bytes.legend(handles_bytes + handles_count, labels_bytes + labels_count, fontsize=16, loc="best")
+        plt.title(f"Memory usage vs. Number of elements - {base_filename}", fontsize=16)
+
     plt.tight_layout(w_pad=2, h_pad=2)
 
     output_path = os.path.join(PLOTS_DIR, f"{base_filename}_analysis.png")
@@ -42,7 +42,7 @@ struct Args {
         .value = 512,
         .min = 1,
         .validator = [this]() -> ArgValidationResult {
-            return {upper > lower, "-u must be > -l"};
+            return {upper >= lower, "-u must be >= -l"};
         },
     };
     Arg step{
@@ -61,10 +61,27 @@ struct Args {
             return {gen_max > gen_min, "-gmax must be > -gmin"};
         },
     };
+    Arg seed{
+        .name = "-seed",
+        .value = -1, // random
+        .min = 0,
+    };
+    Arg resume{
+        .name = "-resume",
+        .value = 0,
+        .min = 0,
+        .max = 1,
+    };
+    Arg batch{
+        .name = "-batch",
+        .value = 0,
+        .min = 0,
+        .max = 1,
+    };
 
 private:
-    typedef std::array<Arg *, 6> args_array_t;
-    args_array_t m_args{&runs, &lower, &upper, &step, &gen_min, &gen_max};
+    typedef std::array<Arg *, 9> args_array_t;
+    args_array_t m_args{&runs, &lower, &upper, &step, &gen_min, &gen_max, &seed, &resume, &batch};
 
 public:
     args_array_t::iterator begin() {
@@ -87,6 +104,9 @@ struct ParsedArgs {
     int64_t step;
     int64_t gen_min;
     int64_t gen_max;
+    int64_t seed;
+    bool resume;
+    bool batch;
 
     explicit ParsedArgs(const Args &args)
         : runs(args.runs.value),
@@ -94,12 +114,15 @@ struct ParsedArgs {
           upper(args.upper.value),
           step(args.step.value),
           gen_min(args.gen_min.value),
-          gen_max(args.gen_max.value) {
+          gen_max(args.gen_max.value),
+          seed(args.seed.value),
+          resume(args.resume.value),
+          batch(args.batch.value) {
     }
 };
 
 inline auto usage_string = "Usage: algorithm_analysis_homework1 -r <int64:runs> -l <int64:lower> -u <int64:upper> "
-        "-s <int64:step> -gmin <int64:gen_min> -gmax <int64:gen_max>";
+        "-s <int64:step> -gmin <int64:gen_min> -gmax <int64:gen_max> -seed <int64:seed> -resume <0|1> -batch <0|1>";
 
 inline ParsedArgs parse_args(const int argc, const char *const *const argv) {
     using std::cerr, std::endl, std::strcmp, std::exit;
@@ -0,0 +1,153 @@
+#include "closest_pair_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#include "../common.hpp"
+#include "../utils_improved.hpp"
+#include "../brute_force/brute_force_improved.hpp"
+#include "../brute_force/brute_force_small.hpp"
+
+// Sets up to this size are solved with brute force, bigger ones with divide and conquer (crossover measured at -O0)
+static constexpr size_t BATCH_BRUTE_FORCE_MAX_SIZE = 256;
+// Number of consecutive sets a worker thread takes at once
+static constexpr size_t BATCH_BLOCK_SIZE = 64;
+
+struct batch_scratch {
+    points_t sorted_x;
+    points_t buffer;
+};
+
+/**
+ * Divide and conquer over a range sorted by x, which is left sorted by y by merging both halves on the way up.
+ * Unlike divide_and_conquer_improved, it doesn't allocate, buffer has to hold at least size points.
+ */
+inline uint64_t divide_and_conquer_merge( // NOLINT(*-no-recursion)
+    Point *points,
+    Point *buffer,
+    const size_t size
+) {
+    if (size <= 3) {
+        uint64_t min_distance = UINT64_MAX;
+
+        for (size_t i = 0; i < size - 1; i++) {
+            for (size_t j = i + 1; j < size; j++) {
+                const uint64_t distance = get_pseudo_distance(points[i], points[j]);
+                if (distance == 0)
+                    return 0;
+
+                min_distance = MIN(min_distance, distance);
+            }
+        }
+
+        std::ranges::sort(points, points + size, {}, &Point::y);
+        return min_distance;
+    }
+
+    const size_t mid = size / 2;
+    const coord_t mid_x = points[mid].x;
+
+    const uint64_t min_distance_left = divide_and_conquer_merge(points, buffer, mid);
+    if (min_distance_left == 0)
+        return 0;
+
+    const uint64_t min_distance_right = divide_and_conquer_merge(points + mid, buffer, size - mid);
+    if (min_distance_right == 0)
+        return 0;
+
+    uint64_t min_distance = MIN(min_distance_left, min_distance_right);
+
+    std::ranges::merge(points, points + mid, points + mid, points + size, buffer, {}, &Point::y, &Point::y);
+    std::ranges::copy(buffer, buffer + size, points);
+
+    size_t strip_size = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        const uint64_t diff = (points[i].x - mid_x) & COORD_MAX; // equivalent to std::abs (not inlined in -O0)
+        if (diff * diff < min_distance) {
+            buffer[strip_size++] = points[i];
+        }
+    }
+
+    for (size_t i = 0; i < strip_size; i++) {
+        const auto &p1 = buffer[i];
+        for (size_t j = i + 1; j < strip_size; j++) {
+            const uint64_t diff = buffer[j].y - p1.y;
+            if (diff * diff >= min_distance)
+                break;
+
+            const uint64_t distance = get_pseudo_distance(p1, buffer[j]);
+            if (distance == 0)
+                return 0;
+
+            min_distance = MIN(min_distance, distance);
+        }
+    }
+
+    return min_distance;
+}
+
+inline double closest_pair_set(const points_t &points, const size_t low, const size_t high, batch_scratch &scratch) {
+    const size_t size = high - low;
+
+    if (size < 2)
+        return DOUBLE_MAX;
+
+    if (size <= BRUTE_FORCE_SMALL_MAX_SIZE)
+        return std::sqrt(brute_force_range_small(points, low, high));
+
+    if (size <= BATCH_BRUTE_FORCE_MAX_SIZE)
+        return std::sqrt(brute_force_range_improved(points, low, high));
+
+    // Scratch buffers only grow, so they stop allocating once they fit the biggest set
+    scratch.sorted_x.assign(points.begin() + low, points.begin() + high);
+    scratch.buffer.resize(MAX(scratch.buffer.size(), size));
+
+    std::ranges::sort(scratch.sorted_x, {}, &Point::x);
+
+    return std::sqrt(divide_and_conquer_merge(scratch.sorted_x.data(), scratch.buffer.data(), size));
+}
+
+std::vector<double> closest_pair_batch(const points_t &points, const std::vector<size_t> &offsets, unsigned threads) {
+    const size_t sets = offsets.empty() ? 0 : offsets.size() - 1;
+    const size_t blocks = (sets + BATCH_BLOCK_SIZE - 1) / BATCH_BLOCK_SIZE;
+    std::vector<double> distances(sets);
+
+    if (threads == 0)
+        threads = MAX(std::thread::hardware_concurrency(), 1u);
+
+    threads = MIN(threads, MAX(blocks, 1));
+
+    std::atomic<size_t> next_block = 0;
+
+    const auto worker = [&] {
+        batch_scratch scratch;
+
+        for (size_t block = next_block++; block < blocks; block = next_block++) {
+            const size_t first_set = block * BATCH_BLOCK_SIZE;
+            const size_t last_set = MIN(first_set + BATCH_BLOCK_SIZE, sets);
+
+            for (size_t i = first_set; i < last_set; i++) {
+                distances[i] = closest_pair_set(points, offsets[i], offsets[i + 1], scratch);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+
+    return distances;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../common.hpp"
+
+/**
+ * Compute the min distance of many point sets at once.
+ * Small sets are solved with brute force in place, the smallest ones with the unrolled kernels of brute_force_small.
+ * Bigger ones use a divide and conquer which reuses per thread scratch buffers instead of allocating on every set.
+ * Sets are distributed among worker threads, which are created on every call and joined before returning, so their
+ * startup cost is part of the time it takes.
+ *
+ * @param points All point sets, concatenated.
+ * @param offsets Start of each set in points, followed by points.size(). Set i is [offsets[i], offsets[i + 1]).
+ * @param threads Number of worker threads. 0 to use as many as hardware threads are available.
+ * @return Min distance of each set. Sets with less than 2 points get DOUBLE_MAX.
+ */
+std::vector<double> closest_pair_batch(const points_t &points, const std::vector<size_t> &offsets, unsigned threads = 0);
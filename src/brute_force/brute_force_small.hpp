@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "../common.hpp"
+#include "../utils_improved.hpp"
+#include "brute_force_improved.hpp"
+
+// Sizes up to this one have their own fully unrolled kernel
+static constexpr size_t BRUTE_FORCE_SMALL_MAX_SIZE = 32;
+
+typedef uint64_t (*brute_force_kernel_t)(const Point *points);
+
+// Branch-free equivalent of MIN for uint64_t
+#define BRANCHLESS_MIN(a, b) ((b) ^ (((a) ^ (b)) & -static_cast<uint64_t>((a) < (b))))
+
+/**
+ * Min pseudo distance between points[I] and every point after it, unrolled at compile time.
+ * Distances are computed inline instead of calling get_pseudo_distance, since nothing is inlined in -O0.
+ */
+template <size_t I, size_t... J>
+uint64_t brute_force_small_row(const Point *points, std::index_sequence<J...>) {
+    const Point p1 = points[I];
+    uint64_t min_distance = UINT64_MAX;
+    uint64_t diff1, diff2, distance;
+
+    ((diff1 = (p1.x - points[I + 1 + J].x) & COORD_MAX, // equivalent to std::abs (not inlined in -O0)
+      diff2 = (p1.y - points[I + 1 + J].y) & COORD_MAX, // equivalent to std::abs (not inlined in -O0)
+      distance = diff1 * diff1 + diff2 * diff2,
+      min_distance = BRANCHLESS_MIN(min_distance, distance)), ...);
+
+    return min_distance;
+}
+
+template <size_t N, size_t... I>
+uint64_t brute_force_small_rows(const Point *points, std::index_sequence<I...>) {
+    uint64_t min_distance = UINT64_MAX;
+    uint64_t row_min_distance;
+
+    ((row_min_distance = brute_force_small_row<I>(points, std::make_index_sequence<N - 1 - I>{}),
+      min_distance = BRANCHLESS_MIN(min_distance, row_min_distance)), ...);
+
+    return min_distance;
+}
+
+/**
+ * Min pseudo distance of exactly N points. Every pair is compared, without loops nor the early return on duplicates.
+ */
+template <size_t N>
+uint64_t brute_force_small_kernel(const Point *points) {
+    if constexpr (N < 2) {
+        return UINT64_MAX;
+    } else {
+        return brute_force_small_rows<N>(points, std::make_index_sequence<N - 1>{});
+    }
+}
+
+template <size_t... N>
+consteval std::array<brute_force_kernel_t, sizeof...(N)> make_brute_force_small_kernels(std::index_sequence<N...>) {
+    return {brute_force_small_kernel<N>...};
+}
+
+// Kernel for each size, indexed by size
+inline constexpr auto BRUTE_FORCE_SMALL_KERNELS = make_brute_force_small_kernels(
+    std::make_index_sequence<BRUTE_FORCE_SMALL_MAX_SIZE + 1>{}
+);
+
+inline uint64_t brute_force_range_small(const points_t &points, const size_t low, const size_t high) {
+    return BRUTE_FORCE_SMALL_KERNELS[high - low](points.data() + low);
+}
+
+inline double brute_force_small(const points_t &points) {
+    if (points.size() > BRUTE_FORCE_SMALL_MAX_SIZE)
+        return brute_force_improved(points);
+
+    return std::sqrt(brute_force_range_small(points, 0, points.size()));
+}
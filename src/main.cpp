@@ -1,22 +1,39 @@
 #include <filesystem>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "args.hpp"
+#include "batch/closest_pair_batch.hpp"
 #include "brute_force/brute_force.hpp"
 #include "brute_force/brute_force_improved.hpp"
+#include "brute_force/brute_force_small.hpp"
 #include "divide_and_conquer/divide_and_conquer.hpp"
 #include "divide_and_conquer/divide_and_conquer_improved.hpp"
 #include "uhr/uhr.hpp"
+#include "uhr/uhr_batch.hpp"
 
 const std::string DATA_DIR = "../data";
+const std::string BATCH_DATA_DIR = DATA_DIR + "/batch";
+
+// Sizes past 256 go through the divide and conquer of closest_pair_batch instead of brute force
+const std::vector<uint64_t> BATCH_SET_SIZES = {8, 16, 32, 64, 128, 256, 512, 1024};
+constexpr uint64_t BATCH_TOTAL_POINTS = 1 << 16;
+// With coordinates in [0, 1000 * n], a set of n points has about a 1 in 2 million chance of a duplicate
+constexpr uint64_t BATCH_RANGE_PER_POINT = 1000;
+
+// brute_force_small is only benchmarked a bit past its unrolled kernels
+constexpr int64_t BRUTE_FORCE_SMALL_UPPER = 2 * BRUTE_FORCE_SMALL_MAX_SIZE;
 
 inline points_t setup(const uint64_t n, int_generator<coord_t> &generator) {
     points_t points(n);
+    const auto stream = generator.stream(n);
 
-    for (size_t i = 0; i < n; i++) {
-        points[i] = {generator(), generator()};
-    }
+    parallel_for(n, [&](const uint64_t begin, const uint64_t end) {
+        for (size_t i = begin; i < end; i++) {
+            points[i] = {stream(2 * i), stream(2 * i + 1)};
+        }
+    });
 
     return points;
 }
@@ -24,19 +41,36 @@ inline points_t setup(const uint64_t n, int_generator<coord_t> &generator) {
 void run_uhr(
     const std::string &filePath,
     const std::function<double(const points_t &)> &fn_to_test,
-    const ParsedArgs &args
+    const ParsedArgs &args,
+    const uint64_t seed
 ) {
+    const auto fn = *fn_to_test.target<double(*)(const points_t &)>();
+    const int64_t upper = fn == brute_force
+                              ? MIN(args.upper, 768)
+                              : fn == brute_force_small
+                              ? MIN(args.upper, BRUTE_FORCE_SMALL_UPPER)
+                              : args.upper;
+
+    if (upper < args.lower)
+        return;
+
+    // When resuming without -seed, keep the seed of the previous run so the inputs don't change
+    const uint64_t test_seed = args.resume && args.seed < 0 ? previous_seed(filePath).value_or(seed) : seed;
+
     uhr<coord_t, points_t, double>(
         filePath,
         args.runs,
         args.lower,
-        *fn_to_test.target<double(*)(const points_t &)>() == brute_force ? MIN(args.upper, 768) : args.upper,
+        upper,
         args.step,
         args.gen_min,
         args.gen_max,
+        test_seed,
+        args.resume,
         setup,
         fn_to_test,
-        brute_force_improved
+        brute_force_improved,
+        points_to_string
     );
 }
 
@@ -46,11 +80,33 @@ int main(const int argc, const char *const *const argv) {
     }
 
     const ParsedArgs &args = parse_args(argc, argv);
+    // Random seeds are kept within int64 so they can be passed back with -seed
+    const uint64_t seed = args.seed >= 0 ? args.seed : random_seed() & INT64_MAX;
+
+    run_uhr(DATA_DIR + "/brute_force.csv", brute_force, args, seed);
+    run_uhr(DATA_DIR + "/brute_force_improved.csv", brute_force_improved, args, seed);
+    run_uhr(DATA_DIR + "/brute_force_small.csv", brute_force_small, args, seed);
+    run_uhr(DATA_DIR + "/divide_and_conquer.csv", divide_and_conquer, args, seed);
+    run_uhr(DATA_DIR + "/divide_and_conquer_improved.csv", divide_and_conquer_improved, args, seed);
 
-    run_uhr(DATA_DIR + "/brute_force.csv", brute_force, args);
-    run_uhr(DATA_DIR + "/brute_force_improved.csv", brute_force_improved, args);
-    run_uhr(DATA_DIR + "/divide_and_conquer.csv", divide_and_conquer, args);
-    run_uhr(DATA_DIR + "/divide_and_conquer_improved.csv", divide_and_conquer_improved, args);
+    if (args.batch) {
+        if (!std::filesystem::exists(BATCH_DATA_DIR)) {
+            std::filesystem::create_directory(BATCH_DATA_DIR);
+        }
+
+        uhr_batch(
+            BATCH_DATA_DIR + "/closest_pair_batch.csv",
+            args.runs,
+            BATCH_SET_SIZES,
+            BATCH_TOTAL_POINTS,
+            BATCH_RANGE_PER_POINT,
+            seed,
+            [](const points_t &points, const std::vector<size_t> &offsets) {
+                return closest_pair_batch(points, offsets);
+            },
+            divide_and_conquer_improved
+        );
+    }
 
     return 0;
 }
@@ -13,9 +13,13 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "uhr_memory.hpp"
+#include "uhr_output.hpp"
 #include "uhr_utils.hpp"
 
 /**
@@ -31,9 +35,13 @@
  * @param step Step of test cases. Should be > 0.
  * @param generator_min Min value the int_generator passed to setup_fn should generate.
  * @param generator_max Max value the int_generator passed to setup_fn should generate.
+ * @param seed Seed of the int_generator passed to setup_fn. The input of each test case only depends on it, the
+ * generator range and n. When resuming, it has to match the seed of the previous run.
+ * @param resume Whether to keep the test cases already present in filePath and only run the missing ones.
  * @param setup_fn Function to call on test setup.
  * @param fn_to_test Function to test.
  * @param control_fn Control function for to the test function.
+ * @param input_to_string Function to serialize the input of a failed test case, which is dumped for replay.
  */
 template <typename IntType, typename Arg, typename R>
 void uhr(
@@ -44,31 +52,72 @@ void uhr(
     const uint64_t step,
     const int64_t generator_min,
     const int64_t generator_max,
+    const uint64_t seed,
+    const bool resume,
     const std::function<Arg(uint64_t n, int_generator<IntType> &generator)> &setup_fn,
     const std::function<R(const Arg &)> &fn_to_test,
-    const std::function<R(const Arg &)> &control_fn
+    const std::function<R(const Arg &)> &control_fn,
+    const std::function<std::string(const Arg &)> &input_to_string
 ) {
     validate_input(runs, lower, upper, step);
 
-    const uint64_t total_runs_additive = runs * ((upper - lower) / step + 1);
+    const run_parameters parameters{runs, lower, upper, step, generator_min, generator_max, seed};
+
+    // Test cases measured by a previous run, which won't be measured again
+    std::set<uint64_t> completed;
+    if (resume) {
+        validate_resume(filePath, parameters);
+        completed = load_completed_cases(filePath, CSV_HEADER);
+    }
+
+    std::vector<uint64_t> pending_cases;
+    for (uint64_t n = lower; n <= upper; n += step) {
+        if (!completed.contains(n)) {
+            pending_cases.push_back(n);
+        }
+    }
+
+    const uint64_t total_runs_additive = runs * pending_cases.size();
     std::vector<double> times(runs);
     std::vector<double> q;
     std::chrono::duration<double, std::nano> elapsed_time{};
+    allocation_stats memory{};
 
     // Set up random number generation
     // ReSharper disable once CppTooWideScope
-    int_generator<IntType> generator(generator_min, generator_max);
+    int_generator<IntType> generator(seed, generator_min, generator_max);
 
     // File to write time data
-    std::ofstream time_data(filePath);
-    time_data << "n,t_mean,t_stdev,t_Q0,t_Q1,t_Q2,t_Q3,t_Q4\n";
+    std::ofstream time_data;
+    if (completed.empty()) {
+        time_data.open(filePath);
+        time_data << CSV_HEADER << '\n';
+    } else {
+        time_data.open(filePath, std::ios::app);
+    }
+
+    // A resumed results file keeps the start time of the run which created it
+    const std::string now = utc_timestamp(std::chrono::system_clock::now());
+    std::string started_at = now;
+    std::optional<std::string> resumed_at;
+
+    if (!completed.empty()) {
+        started_at = read_metadata_field(filePath, "started_at").value_or(now);
+        resumed_at = now;
+    }
+
+    write_metadata(filePath, parameters, started_at, resumed_at, completed.size(), false);
 
     // Begin testing
     const std::string test_name = std::filesystem::path(filePath).stem().string();
-    std::cout << "Running " << test_name << " tests...\n\n";
+    std::cout << "Running " << test_name << " tests with seed " << seed << "...\n";
+    if (!completed.empty()) {
+        std::cout << "Resuming, " << completed.size() << " test cases already done.\n";
+    }
+    std::cout << '\n';
     uint64_t executed_runs = 0;
 
-    for (uint64_t n = lower; n <= upper; n += step) {
+    for (const uint64_t n: pending_cases) {
         double mean_time = 0;
         double time_stdev = 0;
 
@@ -80,15 +129,32 @@ void uhr(
             // Remember to change total depending on step type
             display_progress(++executed_runs, total_runs_additive);
 
+            if constexpr (TRACK_MEMORY) {
+                if (i == 0) {
+                    reset_allocation_stats();
+                }
+            }
+
             auto begin_time = std::chrono::high_resolution_clock::now();
             // Function to test goes here
             const R &result = fn_to_test(arg);
             auto end_time = std::chrono::high_resolution_clock::now();
 
+            // Allocations only depend on the input, so the first run is enough
+            if constexpr (TRACK_MEMORY) {
+                if (i == 0) {
+                    memory = get_allocation_stats();
+                }
+            }
+
             if (i == 0) {
                 const R &expected = control_fn(arg);
                 if (result != expected) {
-                    std::cerr << "Test failed! Expected " << expected << " but got " << result << '\n';
+                    const std::string &dump_path = dump_failed_input(
+                        filePath, n, seed, generator_min, generator_max, expected, result, input_to_string(arg)
+                    );
+                    std::cerr << "Test failed! Expected " << expected << " but got " << result
+                            << ". Input dumped to " << dump_path << '\n';
                 }
             }
 
@@ -112,11 +178,22 @@ void uhr(
         quartiles(times, q);
 
         time_data << n << ',' << mean_time << ',' << time_stdev << ',';
-        time_data << q[0] << ',' << q[1] << ',' << q[2] << ',' << q[3] << ',' << q[4] << '\n';
+        time_data << q[0] << ',' << q[1] << ',' << q[2] << ',' << q[3] << ',' << q[4];
+
+        if constexpr (TRACK_MEMORY) {
+            time_data << ',' << memory.count << ',' << memory.bytes << ',' << memory.peak_bytes;
+        }
+
+        time_data << '\n';
+
+        // Flush every test case so an interrupted run can be resumed without losing it
+        time_data.flush();
     }
 
     // This is to keep loading bar after testing
     std::cout << "\n\n" << test_name << " done!" << std::endl;
 
     time_data.close();
+
+    write_metadata(filePath, parameters, started_at, resumed_at, completed.size(), true);
 }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "uhr_utils.hpp"
+#include "../common.hpp"
+#include "../utils_improved.hpp"
+
+/**
+ * Measure the throughput, in sets per second, of a batch function against calling a single set function on every
+ * set one by one. Each set size is measured on total_points / n sets of n points.
+ * Coordinates are generated in [0, range_per_point * n], so duplicate points, which make both functions return early,
+ * stay unlikely as n grows.
+ *
+ * @param filePath Path of the file where throughput data will be written.
+ * @param runs Number of runs per set size. Should be >= 32.
+ * @param set_sizes Sizes (n) of the sets to test.
+ * @param total_points Number of points across all sets of each size.
+ * @param range_per_point Range of the generated coordinates per point of the set.
+ * @param seed Seed of the generated coordinates.
+ * @param batch_fn Batch function to test.
+ * @param single_fn Single set function to compare against. Also used to check the results of batch_fn.
+ */
+inline void uhr_batch(
+    const std::string &filePath,
+    const uint64_t runs,
+    const std::vector<uint64_t> &set_sizes,
+    const uint64_t total_points,
+    const uint64_t range_per_point,
+    const uint64_t seed,
+    const std::function<std::vector<double>(const points_t &, const std::vector<size_t> &)> &batch_fn,
+    const std::function<double(const points_t &)> &single_fn
+) {
+    const uint64_t total_runs = runs * set_sizes.size();
+    std::vector<double> batch_times(runs), single_times(runs);
+    std::vector<double> q;
+
+    std::ofstream throughput_data(filePath);
+    throughput_data << "n,sets,batch_t_median,batch_sets_per_second,single_t_median,single_sets_per_second\n";
+
+    const std::string test_name = std::filesystem::path(filePath).stem().string();
+    std::cout << "Running " << test_name << " tests with seed " << seed << "...\n\n";
+    uint64_t executed_runs = 0;
+
+    for (const uint64_t n: set_sizes) {
+        const uint64_t sets = MAX(total_points / n, 1);
+        const int_generator<coord_t> generator(seed, 0, static_cast<int64_t>(range_per_point * n));
+        const auto stream = generator.stream(n);
+
+        // Sets concatenated for the batch function, and one by one for the single set function
+        points_t points(sets * n);
+        std::vector<size_t> offsets(sets + 1);
+        std::vector<points_t> single_sets(sets);
+
+        for (size_t i = 0; i < sets; i++) {
+            offsets[i] = i * n;
+            single_sets[i].resize(n);
+
+            for (size_t j = 0; j < n; j++) {
+                const uint64_t index = i * n + j;
+                points[index] = single_sets[i][j] = {stream(2 * index), stream(2 * index + 1)};
+            }
+        }
+
+        offsets[sets] = points.size();
+
+        for (size_t i = 0; i < runs; i++) {
+            display_progress(++executed_runs, total_runs);
+
+            auto begin_time = std::chrono::high_resolution_clock::now();
+            const std::vector<double> &batch_results = batch_fn(points, offsets);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            batch_times[i] = std::chrono::duration<double, std::nano>(end_time - begin_time).count();
+
+            std::vector<double> single_results(sets);
+
+            begin_time = std::chrono::high_resolution_clock::now();
+            for (size_t j = 0; j < sets; j++) {
+                single_results[j] = single_fn(single_sets[j]);
+            }
+            end_time = std::chrono::high_resolution_clock::now();
+            single_times[i] = std::chrono::duration<double, std::nano>(end_time - begin_time).count();
+
+            if (i == 0) {
+                for (size_t j = 0; j < sets; j++) {
+                    if (batch_results[j] != single_results[j]) {
+                        std::cerr << "Test failed! Expected " << single_results[j] << " but got " << batch_results[j]
+                                << '\n';
+                        break;
+                    }
+                }
+            }
+        }
+
+        quartiles(batch_times, q);
+        const double batch_median = q[2];
+        quartiles(single_times, q);
+        const double single_median = q[2];
+
+        throughput_data << n << ',' << sets << ',';
+        throughput_data << batch_median << ',' << sets / (batch_median * 1e-9) << ',';
+        throughput_data << single_median << ',' << sets / (single_median * 1e-9) << '\n';
+        throughput_data.flush();
+    }
+
+    std::cout << "\n\n" << test_name << " done!" << std::endl;
+
+    throughput_data.close();
+}
@@ -0,0 +1,117 @@
+#include "uhr_memory.hpp"
+
+#ifdef UHR_TRACK_MEMORY
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Every block is prefixed with its size, so it can be subtracted from the live bytes when freed
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+static std::atomic<uint64_t> allocation_count = 0;
+static std::atomic<uint64_t> allocated_bytes = 0;
+static std::atomic<uint64_t> live_bytes = 0;
+static std::atomic<uint64_t> peak_live_bytes = 0;
+static std::atomic<uint64_t> baseline_live_bytes = 0;
+
+static void *tracked_allocate(const size_t size) noexcept {
+    auto *block = static_cast<unsigned char *>(std::malloc(HEADER_SIZE + size));
+    if (block == nullptr)
+        return nullptr;
+
+    *reinterpret_cast<size_t *>(block) = size;
+
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    const uint64_t live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    return block + HEADER_SIZE;
+}
+
+static void tracked_free(void *pointer) noexcept {
+    if (pointer == nullptr)
+        return;
+
+    auto *block = static_cast<unsigned char *>(pointer) - HEADER_SIZE;
+    live_bytes.fetch_sub(*reinterpret_cast<size_t *>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+static void *tracked_allocate_or_throw(const size_t size) {
+    void *pointer = tracked_allocate(size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+
+    return pointer;
+}
+
+void *operator new(const size_t size) {
+    return tracked_allocate_or_throw(size);
+}
+
+void *operator new[](const size_t size) {
+    return tracked_allocate_or_throw(size);
+}
+
+void *operator new(const size_t size, const std::nothrow_t &) noexcept {
+    return tracked_allocate(size);
+}
+
+void *operator new[](const size_t size, const std::nothrow_t &) noexcept {
+    return tracked_allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void reset_allocation_stats() {
+    allocation_count = 0;
+    allocated_bytes = 0;
+
+    const uint64_t live = live_bytes;
+    baseline_live_bytes = live;
+    peak_live_bytes = live;
+}
+
+allocation_stats get_allocation_stats() {
+    return {allocation_count, allocated_bytes, peak_live_bytes - baseline_live_bytes};
+}
+
+#else
+
+void reset_allocation_stats() {
+}
+
+allocation_stats get_allocation_stats() {
+    return {0, 0, 0};
+}
+
+#endif
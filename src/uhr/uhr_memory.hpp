@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef UHR_TRACK_MEMORY
+inline constexpr bool TRACK_MEMORY = true;
+#else
+inline constexpr bool TRACK_MEMORY = false;
+#endif
+
+/**
+ * Memory usage recorded by the global allocator hook since the last call to reset_allocation_stats.
+ * Only available when built with UHR_TRACK_MEMORY.
+ */
+struct allocation_stats {
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t peak_bytes;
+};
+
+void reset_allocation_stats();
+
+allocation_stats get_allocation_stats();
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#include "uhr_memory.hpp"
+
+inline const std::string CSV_HEADER = std::string("n,t_mean,t_stdev,t_Q0,t_Q1,t_Q2,t_Q3,t_Q4")
+        + (TRACK_MEMORY ? ",alloc_count,alloc_bytes,peak_bytes" : "");
+
+struct run_parameters {
+    uint64_t runs;
+    uint64_t lower;
+    uint64_t upper;
+    uint64_t step;
+    int64_t generator_min;
+    int64_t generator_max;
+    uint64_t seed;
+};
+
+/**
+ * Load the test cases already written to a results file by a previous, possibly interrupted, run.
+ * A trailing line which is missing its newline or some columns was cut off mid-write. It's cut from the file in place
+ * along with everything after it, so the file can be safely appended to. Complete lines are never rewritten.
+ * Exits if the header of the file doesn't match, since its test cases can't be mixed with new ones.
+ *
+ * @param filePath Path of the results file.
+ * @param header Expected header of the results file.
+ * @return Test cases (n values) which don't need to be measured again. Empty if the file doesn't exist.
+ */
+inline std::set<uint64_t> load_completed_cases(const std::string &filePath, const std::string &header) {
+    std::set<uint64_t> completed;
+    // Binary, so offsets match the file even if lines end with \r\n
+    std::ifstream input(filePath, std::ios::binary);
+
+    if (!input)
+        return completed;
+
+    std::string line;
+    std::getline(input, line);
+    if (line.ends_with('\r')) {
+        line.pop_back();
+    }
+
+    if (line != header) {
+        std::cerr << "Cannot resume from " << filePath << ", its header does not match:\n"
+                << line << "\nMove it away or run without -resume." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto columns = std::ranges::count(header, ',');
+    std::streamoff complete_size = input.tellg();
+
+    while (std::getline(input, line)) {
+        if (input.eof() || std::ranges::count(line, ',') != columns)
+            break;
+
+        char *end;
+        const uint64_t n = std::strtoull(line.c_str(), &end, 10);
+        if (end == line.c_str() || *end != ',')
+            break;
+
+        completed.insert(n);
+        complete_size = input.tellg();
+    }
+
+    input.close();
+
+    if (complete_size >= 0 && static_cast<uintmax_t>(complete_size) < std::filesystem::file_size(filePath)) {
+        std::filesystem::resize_file(filePath, complete_size);
+    }
+
+    return completed;
+}
+
+/**
+ * Read the raw value of a field from a JSON sidecar written by write_metadata.
+ *
+ * @param filePath Path of the results file the sidecar belongs to.
+ * @param key Name of the field.
+ * @return Value of the field as written, without quotes. Empty if the sidecar or the field doesn't exist.
+ */
+inline std::optional<std::string> read_metadata_field(const std::string &filePath, const std::string &key) {
+    std::ifstream metadata(std::filesystem::path(filePath).replace_extension(".json"));
+    const std::string needle = '"' + key + "\": ";
+    std::string line;
+
+    while (std::getline(metadata, line)) {
+        const size_t position = line.find(needle);
+        if (position == std::string::npos)
+            continue;
+
+        std::string value = line.substr(position + needle.size());
+        if (value.ends_with(',')) {
+            value.pop_back();
+        }
+
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+
+        return value;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * Check that the previous run which wrote a results file used the same parameters as the current one, since their
+ * test cases can't be mixed otherwise. Exits on a mismatch, leaving both the results file and its sidecar untouched.
+ *
+ * @param filePath Path of the results file.
+ * @param parameters Parameters of the current run.
+ */
+inline void validate_resume(const std::string &filePath, const run_parameters &parameters) {
+    using std::cerr, std::endl, std::exit;
+
+    if (!std::filesystem::exists(filePath))
+        return;
+
+    if (!std::filesystem::exists(std::filesystem::path(filePath).replace_extension(".json"))) {
+        cerr << "Warning: " << filePath << " has no sidecar, its parameters can't be checked before resuming." << endl;
+        return;
+    }
+
+    const std::vector<std::pair<std::string, std::string>> fields = {
+        {"runs", std::to_string(parameters.runs)},
+        {"generator_min", std::to_string(parameters.generator_min)},
+        {"generator_max", std::to_string(parameters.generator_max)},
+        {"seed", std::to_string(parameters.seed)},
+    };
+
+    for (const auto &[key, value]: fields) {
+        const std::optional<std::string> &previous_value = read_metadata_field(filePath, key);
+
+        if (previous_value && *previous_value != value) {
+            cerr << "Cannot resume from " << filePath << ", it was run with " << key << " = " << *previous_value
+                    << " but now it's " << value << '.' << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * Get the seed of the previous run which wrote a results file, so resuming it keeps generating the same inputs.
+ *
+ * @param filePath Path of the results file.
+ * @return Seed of the previous run. Empty if there's no results file or its sidecar has no seed.
+ */
+inline std::optional<uint64_t> previous_seed(const std::string &filePath) {
+    if (!std::filesystem::exists(filePath))
+        return std::nullopt;
+
+    const std::optional<std::string> &seed = read_metadata_field(filePath, "seed");
+    if (!seed)
+        return std::nullopt;
+
+    char *end;
+    const uint64_t value = std::strtoull(seed->c_str(), &end, 10);
+    if (end == seed->c_str() || *end != '\0')
+        return std::nullopt;
+
+    return value;
+}
+
+inline std::string json_escape(const std::string &string) {
+    std::ostringstream stream;
+
+    for (const char c: string) {
+        switch (c) {
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            case '\t':
+                stream << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                            << std::dec << std::setfill(' ');
+                } else {
+                    stream << c;
+                }
+        }
+    }
+
+    return stream.str();
+}
+
+inline std::string utc_timestamp(const std::chrono::system_clock::time_point time) {
+    const std::time_t t = std::chrono::system_clock::to_time_t(time);
+    std::ostringstream stream;
+    stream << std::put_time(std::gmtime(&t), "%Y-%m-%dT%H:%M:%SZ");
+    return stream.str();
+}
+
+inline std::string host_name() {
+#ifdef _WIN32
+    char name[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD size = sizeof(name);
+    if (GetComputerNameA(name, &size))
+        return {name, size};
+#else
+    char name[256];
+    if (gethostname(name, sizeof(name)) == 0) {
+        name[sizeof(name) - 1] = '\0';
+        return name;
+    }
+#endif
+    return "unknown";
+}
+
+inline std::string host_os() {
+#ifdef _WIN32
+    return "Windows";
+#else
+    utsname info{};
+    if (uname(&info) == 0)
+        return std::string(info.sysname) + ' ' + info.release + ' ' + info.machine;
+
+    return "unknown";
+#endif
+}
+
+inline std::string compiler_version() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+/**
+ * Write the JSON sidecar of a results file, holding the parameters of the run along with host and build metadata.
+ * It's written next to the results file, with the same name and a .json extension.
+ *
+ * @param filePath Path of the results file.
+ * @param parameters Parameters the run was started with.
+ * @param started_at Time at which the first run which wrote the results file started.
+ * @param resumed_at Time at which the current run resumed the results file. Empty if it didn't resume it.
+ * @param resumed_cases Number of test cases loaded from a previous run instead of being measured.
+ * @param finished Whether the run has finished.
+ */
+inline void write_metadata(
+    const std::string &filePath,
+    const run_parameters &parameters,
+    const std::string &started_at,
+    const std::optional<std::string> &resumed_at,
+    const size_t resumed_cases,
+    const bool finished
+) {
+    const std::filesystem::path path(filePath);
+    std::ofstream metadata(std::filesystem::path(path).replace_extension(".json"));
+
+#ifdef NDEBUG
+    constexpr bool assertions = false;
+#else
+    constexpr bool assertions = true;
+#endif
+
+    metadata << "{\n"
+            << "  \"test\": \"" << json_escape(path.stem().string()) << "\",\n"
+            << "  \"results\": \"" << json_escape(path.filename().string()) << "\",\n"
+            << "  \"columns\": \"" << CSV_HEADER << "\",\n"
+            << "  \"started_at\": \"" << json_escape(started_at) << "\",\n"
+            << "  \"resumed_at\": ";
+
+    if (resumed_at)
+        metadata << '"' << json_escape(*resumed_at) << "\",\n";
+    else
+        metadata << "null,\n";
+
+    metadata << "  \"finished_at\": ";
+
+    if (finished)
+        metadata << '"' << utc_timestamp(std::chrono::system_clock::now()) << "\",\n";
+    else
+        metadata << "null,\n";
+
+    metadata << "  \"resumed_cases\": " << resumed_cases << ",\n"
+            << "  \"parameters\": {\n"
+            << "    \"runs\": " << parameters.runs << ",\n"
+            << "    \"lower\": " << parameters.lower << ",\n"
+            << "    \"upper\": " << parameters.upper << ",\n"
+            << "    \"step\": " << parameters.step << ",\n"
+            << "    \"generator_min\": " << parameters.generator_min << ",\n"
+            << "    \"generator_max\": " << parameters.generator_max << ",\n"
+            << "    \"seed\": " << parameters.seed << "\n"
+            << "  },\n"
+            << "  \"host\": {\n"
+            << "    \"name\": \"" << json_escape(host_name()) << "\",\n"
+            << "    \"os\": \"" << json_escape(host_os()) << "\",\n"
+            << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << "\n"
+            << "  },\n"
+            << "  \"build\": {\n"
+            << "    \"compiler\": \"" << json_escape(compiler_version()) << "\",\n"
+            << "    \"cxx_standard\": " << __cplusplus << ",\n"
+            << "    \"assertions\": " << (assertions ? "true" : "false") << ",\n"
+            << "    \"track_memory\": " << (TRACK_MEMORY ? "true" : "false") << ",\n"
+            << "    \"compiled_at\": \"" << __DATE__ << ' ' << __TIME__ << "\"\n"
+            << "  }\n"
+            << "}\n";
+}
+
+/**
+ * Dump the input of a failed test case next to the results file, as <test>_failed_<n>.txt.
+ * Since inputs only depend on the seed, the generator range and n, the test case can be replayed with
+ * -seed <seed> -gmin <generator_min> -gmax <generator_max> -l <n> -u <n>.
+ *
+ * @param filePath Path of the results file.
+ * @param n Failed test case.
+ * @param seed Seed the input was generated with.
+ * @param generator_min Min value the input was generated with.
+ * @param generator_max Max value the input was generated with.
+ * @param expected Result of the control function.
+ * @param result Result of the tested function.
+ * @param input Serialized input.
+ * @return Path of the dump.
+ */
+template <typename R>
+std::string dump_failed_input(
+    const std::string &filePath,
+    const uint64_t n,
+    const uint64_t seed,
+    const int64_t generator_min,
+    const int64_t generator_max,
+    const R &expected,
+    const R &result,
+    const std::string &input
+) {
+    const std::filesystem::path path(filePath);
+    const std::filesystem::path dump_path = path.parent_path()
+            / (path.stem().string() + "_failed_" + std::to_string(n) + ".txt");
+
+    std::ofstream dump(dump_path);
+    dump << std::setprecision(17)
+            << "# Expected " << expected << " but got " << result << '\n'
+            << "# Replay with: -seed " << seed << " -gmin " << generator_min << " -gmax " << generator_max
+            << " -l " << n << " -u " << n << '\n'
+            << input << '\n';
+
+    return dump_path.string();
+}
@@ -12,23 +12,95 @@
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 static constexpr int MIN_RUNS = 32;
+// Inputs smaller than this are generated on the calling thread
+static constexpr uint64_t MIN_PARALLEL_SIZE = 1 << 15;
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t random_seed() {
+    return (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+}
+
+/**
+ * Counter-based stream of random ints: the value at each index only depends on the stream key and the index, so
+ * values can be generated in any order and from any number of threads.
+ */
+template <typename IntType>
+class int_stream {
+    uint64_t m_key;
+    int64_t m_min;
+    uint64_t m_range;
 
+public:
+    int_stream(const uint64_t key, const int64_t min, const uint64_t range) : m_key(key), m_min(min), m_range(range) {}
+
+    IntType operator ()(const uint64_t index) const {
+        const uint64_t value = splitmix64(m_key ^ splitmix64(index));
+        // Modulo bias is at most range / 2^64, negligible for the ranges used here
+        // Added as unsigned, since the offset can exceed INT64_MAX when the range spans more than half of int64
+        return static_cast<IntType>(m_range == 0 ? value : static_cast<uint64_t>(m_min) + value % m_range);
+    }
+};
+
+/**
+ * Seeded source of int_streams. The same seed always yields the same streams, on any platform.
+ */
 template <typename IntType>
 class int_generator {
-    std::mt19937_64 m_rng{std::random_device{}()};
-    std::uniform_int_distribution<IntType> m_uniform_distribution;
+    uint64_t m_seed;
+    int64_t m_min;
+    uint64_t m_range;
 
 public:
-    int_generator(int64_t min, int64_t max) : m_uniform_distribution(min, max) {}
+    int_generator(const uint64_t seed, const int64_t min, const int64_t max)
+        : m_seed(seed), m_min(min), m_range(static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1) {}
+
+    [[nodiscard]] uint64_t seed() const {
+        return m_seed;
+    }
 
-    IntType operator ()() {
-        return m_uniform_distribution(m_rng);
+    /**
+     * Get the stream with the given id. Each test case should use its own, e.g. its n, so its input doesn't depend
+     * on which other test cases were run.
+     */
+    [[nodiscard]] int_stream<IntType> stream(const uint64_t id) const {
+        return {splitmix64(m_seed ^ splitmix64(id)), m_min, m_range};
     }
 };
 
+/**
+ * Call fn(begin, end) over contiguous chunks of [0, size), spread across all hardware threads if size is at least
+ * MIN_PARALLEL_SIZE.
+ */
+template <typename Fn>
+void parallel_for(const uint64_t size, const Fn &fn) {
+    const unsigned hardware_threads = std::thread::hardware_concurrency();
+    const uint64_t threads = size < MIN_PARALLEL_SIZE || hardware_threads == 0 ? 1 : hardware_threads;
+    const uint64_t chunk_size = (size + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    for (uint64_t begin = chunk_size; begin < size; begin += chunk_size) {
+        workers.emplace_back(fn, begin, std::min(begin + chunk_size, size));
+    }
+
+    fn(0, std::min(chunk_size, size));
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+}
+
 inline void validate_input(const uint64_t runs, const uint64_t lower, const uint64_t upper, const uint64_t step) {
     using std::cerr, std::endl, std::exit;
 
@@ -3,6 +3,7 @@
 #include "common.hpp"
 
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
 inline uint64_t get_pseudo_distance(const Point &p1, const Point &p2) {
     const uint64_t diff1 = (p1.x - p2.x) & COORD_MAX; // equivalent to std::abs (not inlined in -O0)